@@ -0,0 +1,108 @@
+#ifndef DecoderStats_h
+#define DecoderStats_h
+
+//Run statistics of the decoder.  Every decoding thread fills its own
+//DecoderStats, with no locking, and the owner of the output merges them
+//with add().  Stage timers count CPU cycles (TSC on x86), converted to
+//seconds only when the statistics are written out.
+
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+using namespace std;
+
+//Data quality counters of a board, from the BoardQA of every decoded spill
+struct BoardErrors
+{
+    long nEvents;
+    long nEventIDJumps;
+    long nHitMismatches;
+    long nFlaggedSpills;
+};
+
+//One closed spill
+struct SpillStats
+{
+    int spillID;
+    long nEvents;       //trigger events decoded
+    long nHits;
+    bool ARMdead;
+    bool decoded;       //false if the spill was dropped (ARM dead, no EOS, ...)
+};
+
+class DecoderStats
+{
+public:
+    enum { kRead = 0, kDecode, kFill, nStages };
+    enum { nTypes = 256, nRocs = 256, nBoards = 16 };
+
+    DecoderStats();
+    void clear();
+    void add(const DecoderStats& other);
+
+    void countEvent(const unsigned int* data)
+    {
+        unsigned int eventType = data[1] >> 16;
+        ++eventsByType[eventType < nTypes ? eventType : 0];
+        bytes += 4*(data[0] + 1);
+    }
+    void uncountEvent(const unsigned int* data)
+    {
+        unsigned int eventType = data[1] >> 16;
+        --eventsByType[eventType < nTypes ? eventType : 0];
+        bytes -= 4*(data[0] + 1);
+    }
+    void countHits(int rocID, int boardID, long n) { hits[rocID][boardID & (nBoards-1)] += n; }
+    void countBoardQA(int rocID, int boardID, long nEvents, long nEventIDJumps, long nHitMismatches, bool flagged)
+    {
+        BoardErrors& board = boards[rocID][boardID & (nBoards-1)];
+        board.nEvents += nEvents;
+        board.nEventIDJumps += nEventIDJumps;
+        board.nHitMismatches += nHitMismatches;
+        if(flagged) ++board.nFlaggedSpills;
+    }
+    void countResyncs(long n, long nBytes, long nEvents)
+    {
+        nResyncs += n;
+        skippedBytes += nBytes;
+        skippedEvents += nEvents;
+    }
+    void endSpill(int spillID, long nEvents, long nHits, bool ARMdead, bool decoded);
+
+    long nEvents() const;
+    long nHits() const;
+
+    bool writeJSON(const char* file, const char* input, const vector<DecoderStats>& threads) const;
+    bool writePrometheus(const char* file) const;
+
+    static unsigned long long cycles()
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+    static double toSeconds(unsigned long long cycles);
+    static double wallSeconds();    //since the start of the program
+
+public:
+    unsigned long long stageCycles[nStages];
+    long eventsByType[nTypes];      //unknown types (>= nTypes) are counted as type 0
+    long bytes;
+    long hits[nRocs][nBoards];
+    BoardErrors boards[nRocs][nBoards];
+    long nCorrupt;                  //events evRead could not read
+    long nResyncs;                  //corrupt data skipped by evio to the next good block
+    long skippedBytes;
+    long skippedEvents;
+    long nTruncated;                //ROC bank or trigger TDC data running past the end of its event
+    long nARMdead;
+    vector<SpillStats> spills;
+};
+
+#endif
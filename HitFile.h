@@ -0,0 +1,228 @@
+#ifndef HitFile_h
+#define HitFile_h
+
+//Columnar hit file -- the decoded hits of a run without ROOT.  Written by
+//HitFileWriter (decoder -b), read by HitFileReader below, which is header
+//only and needs nothing but POSIX: link-free for QA tools.
+//
+//Layout, native byte order (checked through HitFileHeader::byteOrder):
+//  HitFileHeader
+//  one chunk per spill, or several in a row for a spill decoded in batches
+//  (decoder -B), the hit columns one after the other, each padded to 8 bytes:
+//    rocID int16[n], boardID int16[n], channelID int16[n], eventID int32[n],
+//    tdcTime double[n], eventTy int32[n]
+//  index, HitFileSpill[nSpills], one per chunk, in the order written
+//  HitFileTrailer, at the very end
+//
+//The reader maps the file and hands out the columns of a spill as spans
+//into the mapping: nothing is copied or converted.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+struct HitFileHeader
+{
+    char magic[8];          //"E906HIT"
+    uint32_t version;
+    uint32_t byteOrder;     //0x01020304 as written
+    uint64_t reserved;
+};
+
+//Index entry of a spill
+struct HitFileSpill
+{
+    int32_t spillID;
+    uint32_t flags;
+    uint64_t nHits;
+    uint64_t offset;        //of the chunk, from the start of the file
+};
+
+struct HitFileTrailer
+{
+    uint64_t indexOffset;
+    uint64_t nSpills;
+    char magic[8];          //"E906END"
+};
+
+struct HitFileFormat
+{
+    enum { version = 1 };
+    static const uint32_t byteOrder = 0x01020304;
+    static const char* headerMagic() { return "E906HIT"; }
+    static const char* trailerMagic() { return "E906END"; }
+
+    //Column sizes of a chunk of n hits, in bytes, padding included
+    static uint64_t padded(uint64_t bytes) { return (bytes + 7) & ~(uint64_t)7; }
+    static uint64_t chunkBytes(uint64_t n) { return 3*padded(2*n) + 2*padded(4*n) + padded(8*n); }
+};
+
+//Column of a spill, in the mapping
+template <typename T>
+struct HitSpan
+{
+    const T* data;
+    size_t n;
+
+    HitSpan() : data(0), n(0) {}
+    HitSpan(const T* d, size_t size) : data(d), n(size) {}
+    size_t size() const { return n; }
+    bool empty() const { return n == 0; }
+    const T& operator[](size_t i) const { return data[i]; }
+    const T* begin() const { return data; }
+    const T* end() const { return data + n; }
+};
+
+//Hits of one spill
+struct HitFileChunk
+{
+    int spillID;
+    size_t nHits;
+    HitSpan<int16_t> rocID;
+    HitSpan<int16_t> boardID;
+    HitSpan<int16_t> channelID;
+    HitSpan<int32_t> eventID;
+    HitSpan<double> tdcTime;
+    HitSpan<int32_t> eventTy;
+};
+
+class HitFileReader
+{
+public:
+    HitFileReader() : map(0), mapSize(0), index(0), nIndex(0) {}
+    explicit HitFileReader(const char* fileName) : map(0), mapSize(0), index(0), nIndex(0) { open(fileName); }
+    ~HitFileReader() { close(); }
+
+    //false if the file cannot be mapped or is not a complete hit file; see error()
+    bool open(const char* fileName)
+    {
+        close();
+        int fd = ::open(fileName, O_RDONLY);
+        if(fd < 0) return fail(std::string("cannot open ") + fileName);
+        struct stat st;
+        if(fstat(fd, &st) != 0 || st.st_size < (off_t)(sizeof(HitFileHeader) + sizeof(HitFileTrailer)))
+        {
+            ::close(fd);
+            return fail(std::string(fileName) + " is too short for a hit file");
+        }
+        void* p = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if(p == MAP_FAILED) return fail(std::string("cannot map ") + fileName);
+        map = (const char*)p;
+        mapSize = st.st_size;
+        return check(fileName);
+    }
+
+    void close()
+    {
+        if(map) munmap((void*)map, mapSize);
+        map = 0;
+        mapSize = 0;
+        index = 0;
+        nIndex = 0;
+    }
+
+    bool isOpen() const { return map != 0; }
+    const std::string& error() const { return errorText; }
+    uint32_t version() const { return ((const HitFileHeader*)map)->version; }
+
+    size_t nSpills() const { return nIndex; }     //index entries, one per chunk
+    const HitFileSpill& spillEntry(size_t i) const { return index[i]; }
+    uint64_t nHits() const
+    {
+        uint64_t n = 0;
+        for(size_t i = 0; i < nIndex; ++i) n += index[i].nHits;
+        return n;
+    }
+
+    //Index of the first chunk of spillID, -1 if there is none
+    long findSpill(int spillID) const
+    {
+        for(size_t i = 0; i < nIndex; ++i)
+        {
+            if(index[i].spillID == spillID) return i;
+        }
+        return -1;
+    }
+
+    //Chunks of the spill whose chunk i is the first, i.e. i .. i+n-1
+    size_t spillChunks(size_t i) const
+    {
+        size_t n = 1;
+        while(i + n < nIndex && index[i + n].spillID == index[i].spillID) ++n;
+        return n;
+    }
+
+    HitFileChunk chunk(size_t i) const
+    {
+        const HitFileSpill& s = index[i];
+        uint64_t n = s.nHits;
+        const char* p = map + s.offset;
+        HitFileChunk c;
+        c.spillID = s.spillID;
+        c.nHits = n;
+        c.rocID = HitSpan<int16_t>((const int16_t*)p, n);        p += HitFileFormat::padded(2*n);
+        c.boardID = HitSpan<int16_t>((const int16_t*)p, n);      p += HitFileFormat::padded(2*n);
+        c.channelID = HitSpan<int16_t>((const int16_t*)p, n);    p += HitFileFormat::padded(2*n);
+        c.eventID = HitSpan<int32_t>((const int32_t*)p, n);      p += HitFileFormat::padded(4*n);
+        c.tdcTime = HitSpan<double>((const double*)p, n);        p += HitFileFormat::padded(8*n);
+        c.eventTy = HitSpan<int32_t>((const int32_t*)p, n);
+        return c;
+    }
+
+private:
+    HitFileReader(const HitFileReader&);
+    HitFileReader& operator=(const HitFileReader&);
+
+    bool fail(const std::string& text)
+    {
+        close();
+        errorText = text;
+        return false;
+    }
+
+    //Header, trailer and every chunk within the file, so that chunk() needs no checks
+    bool check(const char* fileName)
+    {
+        const HitFileHeader* header = (const HitFileHeader*)map;
+        const HitFileTrailer* trailer = (const HitFileTrailer*)(map + mapSize - sizeof(HitFileTrailer));
+        if(memcmp(header->magic, HitFileFormat::headerMagic(), 8) != 0)
+            return fail(std::string(fileName) + " is not a hit file");
+        if(header->byteOrder != HitFileFormat::byteOrder)
+            return fail(std::string(fileName) + " was written with the other byte order");
+        if(header->version > HitFileFormat::version)
+            return fail(std::string(fileName) + " has a newer format version than this reader");
+        if(memcmp(trailer->magic, HitFileFormat::trailerMagic(), 8) != 0)
+            return fail(std::string(fileName) + " is incomplete (no index)");
+
+        uint64_t indexEnd = mapSize - sizeof(HitFileTrailer);
+        if(trailer->indexOffset < sizeof(HitFileHeader) || trailer->indexOffset > indexEnd
+           || trailer->nSpills > (indexEnd - trailer->indexOffset)/sizeof(HitFileSpill)
+           || trailer->indexOffset % 8 != 0)
+            return fail(std::string(fileName) + " has a corrupt index");
+        index = (const HitFileSpill*)(map + trailer->indexOffset);
+        nIndex = trailer->nSpills;
+        for(size_t i = 0; i < nIndex; ++i)
+        {
+            const HitFileSpill& s = index[i];
+            if(s.offset < sizeof(HitFileHeader) || s.offset % 8 != 0 || s.offset > trailer->indexOffset
+               || s.nHits > trailer->indexOffset || HitFileFormat::chunkBytes(s.nHits) > trailer->indexOffset - s.offset)
+                return fail(std::string(fileName) + " has a corrupt index");
+        }
+        errorText.clear();
+        return true;
+    }
+
+    const char* map;
+    size_t mapSize;
+    const HitFileSpill* index;
+    size_t nIndex;
+    std::string errorText;
+};
+
+#endif
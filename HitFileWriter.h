@@ -0,0 +1,50 @@
+#ifndef HitFileWriter_h
+#define HitFileWriter_h
+
+//Writer of the columnar hit file (HitFile.h), one chunk per fill(): per spill,
+//or per batch of a spill decoded in batches.  The
+//index and trailer go out in close(); a file without them is rejected by
+//the reader, so a crashed decoder never leaves a file that looks complete.
+
+#include <stdio.h>
+#include <vector>
+
+#include "HitFile.h"
+#include "SpillDecoder.h"
+
+using namespace std;
+
+class HitFileWriter
+{
+public:
+    HitFileWriter();
+    ~HitFileWriter();
+
+    bool open(const char* fileName);
+    bool fill(int spillID, const vector<Hit>& hits);
+    bool close();
+
+    bool isOpen() const { return fp != 0; }
+    uint64_t nHits() const { return hitCount; }
+
+private:
+    HitFileWriter(const HitFileWriter&);
+    HitFileWriter& operator=(const HitFileWriter&);
+
+    template <typename T> bool writeColumn(const vector<T>& column);
+
+    FILE* fp;
+    uint64_t offset;
+    uint64_t hitCount;
+    vector<HitFileSpill> index;
+
+    //Column buffers, reused from spill to spill
+    vector<int16_t> rocIDs;
+    vector<int16_t> boardIDs;
+    vector<int16_t> channelIDs;
+    vector<int32_t> eventIDs;
+    vector<double> tdcTimes;
+    vector<int32_t> eventTys;
+};
+
+#endif
@@ -0,0 +1,380 @@
+#ifndef SpillDecoder_h
+#define SpillDecoder_h
+
+//Decoding of E906 CODA events into per-spill hit lists.  A SpillDecoder
+//takes the raw events of a run one at a time and hands back the hits
+//of a spill whenever it is closed by the next BOS or the end of run.
+
+#include <vector>
+#include <string>
+#include <stdio.h>
+
+#include <TString.h>
+#include <TTree.h>
+
+#include "DecoderStats.h"
+
+using namespace std;
+
+//Readout map -- ROCs in readout order, the number of boards on each, and
+//the firmware IDs of the V1495 boards.  The default is the compiled-in E906
+//map; read() replaces it by a map file with one ROC per line,
+//  rocID nBoards [v1495 [firmwareID ...]]
+//where V1495 firmware IDs default to 0x400, 0x410, ... for the boards.
+struct RocConfig
+{
+    int rocID;
+    int nBoards;
+    bool v1495;
+    vector<unsigned int> firmwareIDs;   //V1495 boards only, by board number
+};
+
+class RocMap
+{
+public:
+    enum { nFirmwareIDs = 0x1000 };
+
+    RocMap();
+    bool read(const char* mapFile);
+
+    int v1495Board(unsigned int firmwareID) const { return firmwareID < nFirmwareIDs ? v1495Slot[firmwareID] : -1; }
+    static const RocMap& defaultMap();
+
+private:
+    void clear();
+
+public:
+    vector<RocConfig> rocs;
+    short v1495Slot[nFirmwareIDs];  //V1495 firmware ID -> board number, -1 if none
+};
+
+//Trigger event of one TDC board.  Hits are not kept here: they are in the
+//board's flat hit arrays, hits [firstHit, next event's firstHit)
+struct Event
+{
+    enum { kTWTDC = 0, kV1495 };
+
+    int codaEventID;
+    int eventID;
+    int trigger;            //raw trigger time (TW-TDC header / V1495 stop), -1 if none
+    short nEntriesExp;
+    unsigned char kind;
+    bool late;              //streaming: closed after the event builder went past it
+    unsigned int firstHit;
+};
+
+//Data quality of one board in one spill, from TDC::check -- error counts,
+//hits per channel, and flags for a board that should be looked at
+struct BoardQA
+{
+    enum { kEventIDJumps = 1, kHitMismatches = 2, kNoHits = 4, kLate = 8 };
+    static const double maxErrorRate;   //flag above this fraction of events
+
+    void clear(int roc, int board);
+    void setFlags();
+
+    int rocID;
+    int boardID;
+    unsigned int nEvents;
+    unsigned int nHits;
+    unsigned int nEventIDJumps;     //eventID not following the previous one
+    unsigned int nHitMismatches;    //hits read differ from the count in the header
+    unsigned int nLateEvents;       //streaming: events dropped, the board was behind
+    unsigned int flags;
+    vector<int> occupancy;          //hits by channel
+};
+
+//TDC storage -- spill scoped, struct of arrays.  init() at BOS only
+//clears the arrays, so their capacity is reused from spill to spill
+class TDC
+{
+public:
+    TDC();
+    void init();
+    void check(BoardQA& qa, unsigned int first, unsigned int last) const;
+    void compact(unsigned int nBuilt, BoardQA& qa);
+
+    void finalizeEvent(int codaEventID, int eventID);
+    void fillHeader(unsigned int header);
+    void fillV1495Header(unsigned int stop_time, unsigned int n_events);
+    void fillHits(const unsigned int* words, unsigned int n);
+    void fillV1495Hits(const unsigned int* words, unsigned int n);
+
+    unsigned int nHits(unsigned int iEvt) const;
+    double triggerTime(const Event& event) const;
+    double tdcTime(const Event& event, double triggerTime, unsigned int iHit) const;
+    static double decodeTime(unsigned int word);
+    static bool isHitWord(unsigned int word) { return (word >> 31) == 0 && (word >> 28) != 0; }
+
+private:
+    void openEvent();
+
+public:
+    int boardID;
+    vector<Event> events;           //last one is still open
+    vector<short> channels;         //per hit
+    vector<unsigned short> times;   //per hit, raw time field of the hit word
+
+    //Streaming event builder -- events before firstEvent (spill index of
+    //events[0]) were built and dropped, the last of them is kept as previous
+    unsigned int firstEvent;
+    unsigned int nSeen;             //events the builder has looked at
+    Event previous;
+};
+
+//ROC storage
+class ROC
+{
+public:
+    void init();
+    void check(BoardQA* qa) const;
+
+public:
+    int rocID;
+    int nTDCs;
+    vector<TDC> tdcs;
+};
+
+//Output record, one per decoded hit
+struct Hit
+{
+    int rocID;
+    int boardID;
+    int channelID;
+    int eventID;
+    double tdcTime;
+    int eventTy;
+};
+
+//Hit of the FPGA trigger's V1495 TDC stream (type 14 events)
+struct TriggerTDCHit
+{
+    int eventID;            //TS event ID and trigger type of the trigger it belongs to
+    int triggerType;
+    int board;              //TDC in the trigger, in readout order
+    unsigned int boardID;   //its board ID word
+    int channelID;
+    int tdcTime;            //common stop - hit time, in TDC counts
+};
+
+//Trigger event -- its hits are hits[firstHit, firstHit+nHits) of the spill
+struct TriggerEvent
+{
+    int eventID;
+    int eventTy;
+    unsigned int firstHit;
+    unsigned int nHits;
+};
+
+//Slow control readout (type 130) -- text lines "name value ...".  parse()
+//unpacks the text in one pass into a buffer reused from event to event,
+//every line as "name\0value\0", and the entries point into it
+class SlowControl
+{
+public:
+    enum { targetLine = 117 };  //line (blank ones not counted) with the target position
+
+    SlowControl() { clear(); }
+    void clear();
+    void parse(const unsigned int* data, int nWords);
+
+    unsigned int size() const { return entries.size(); }
+    const char* key(unsigned int i) const { return &text[entries[i].key]; }
+    const char* value(unsigned int i) const { return &text[entries[i].value]; }
+
+public:
+    bool hasTargetPos;      //the target line has the expected 4 fields
+    int targetPos;          //its third one
+
+private:
+    struct Entry
+    {
+        unsigned int key;
+        unsigned int value;
+    };
+    unsigned int endLine(unsigned int lineStart, unsigned int lineEnd);
+    void parseTargetLine(unsigned int lineStart, unsigned int lineEnd);
+
+    vector<char> text;
+    vector<Entry> entries;
+    int nLines;
+};
+
+//Spill record, one per decoded spill -- run conditions to join to the hits by spillID
+struct SpillRecord
+{
+    int spillID;
+    int targetPos;
+    int bosEventID;
+    int eosEventID;
+    unsigned int nEvents;   //trigger events with hits
+    unsigned int nHits;
+    unsigned int nBadBoards;    //boards with QA flags
+    SlowControl slowControl;    //last slow control readout of the spill
+    vector<BoardQA> qa;         //every board read out
+    vector<TriggerTDCHit> triggerHits;  //FPGA trigger TDC hits of the spill
+};
+
+//Output tuple -- one entry per hit, or (perEvent) one entry per trigger event
+class HitWriter
+{
+public:
+    HitWriter(TTree* tree, bool perEvent);
+    void fill(int spillID, const vector<Hit>& hits, const vector<TriggerEvent>& events);
+
+private:
+    TTree* saveTree;
+    bool perEvent;
+
+    Hit out;
+
+    int spillID;
+    int eventID;
+    int eventTy;
+    int nHits;
+    vector<int> rocIDs;
+    vector<int> boardIDs;
+    vector<int> channelIDs;
+    vector<double> tdcTimes;
+};
+
+//Spill metadata output -- "spill": one entry per spill, "slowcontrol": one
+//entry per slow control value, spillID/name/value, "qa": one entry per board
+//and spill, the BoardQA, "v1495": one entry per FPGA trigger TDC hit, with
+//its spillID
+class SpillWriter
+{
+public:
+    SpillWriter(TTree* spillTree, TTree* slowControlTree, TTree* qaTree, TTree* triggerTree);
+    void fill(const vector<SpillRecord>& spills);
+
+private:
+    TTree* spillTree;
+    TTree* slowControlTree;
+    TTree* qaTree;
+    TTree* triggerTree;
+
+    int spillID;
+    int targetPos;
+    int bosEventID;
+    int eosEventID;
+    int nEvents;
+    int nHits;
+    int nSlowControl;
+    int nBadBoards;
+    string name;
+    string value;
+    int rocID;
+    int boardID;
+    int nEventIDJumps;
+    int nHitMismatches;
+    int nLateEvents;
+    int flags;
+    vector<int> occupancy;
+    TriggerTDCHit triggerHit;
+};
+
+//Bank headers of the boards read out, one decoder each
+enum BankHeader
+{
+    kTriggerBank = 0xe906f00f,  //trigger types from the TS
+    kV1495Bank = 0xe906f005,    //V1495 trigger TDC
+    kTWTDCBank = 0xe906f018,    //TW-TDC
+    kQIEBank = 0xe906f01b       //QIE
+};
+
+class SpillDecoder;
+
+//Bank decoder -- decodes the bank whose header word is data[iWord], within
+//a ROC bank ending at maxWord, and returns where the ROC bank goes on
+typedef int (*BankDecoder)(SpillDecoder& decoder, ROC* roc, int rocID, const unsigned int* data, int iWord, int maxWord);
+
+//Bank decoder registry -- bank header words are 0xe906f0xx, and the low
+//byte indexes a jump table of decoders
+class BankRegistry
+{
+public:
+    static const unsigned int headerMask = 0xffffff00;
+    static const unsigned int headerPrefix = 0xe906f000;
+
+    static bool add(unsigned int header, BankDecoder decoder);
+    static BankDecoder find(unsigned int word) { return (word & headerMask) == headerPrefix ? table[word & 0xff] : 0; }
+
+private:
+    static BankDecoder table[256];
+};
+
+//Spill decoder -- holds everything that is reset at BOS, so that
+//spills can be decoded independently of each other.
+//
+//By default the boards keep the whole spill and dump() builds the trigger
+//events at its end, aligning the boards by event index.  With buildWindow
+//set, events are built while the spill is read, each as soon as every board
+//has closed it, or once the boards ahead are buildWindow events past it; a
+//board that comes later has its event dropped and is flagged (BoardQA::kLate).
+//Built events wait for the end of the spill, which decides its ID and whether
+//it is kept; beyond maxHits hits they go to a scratch file, and readBatch()
+//hands them back.  Memory then no longer grows with the spill.
+class SpillDecoder
+{
+public:
+    enum { kDecodeOK = 0, kSpillDone, kRunEnd, kARMdead };
+
+    SpillDecoder(const RocMap& map = RocMap::defaultMap());
+    ~SpillDecoder();
+    int processEvent(unsigned int* data);
+    void reset();
+    void dump();
+    void buildEvents(bool spillEnd);
+    bool readBatch();
+
+private:
+    SpillDecoder(const SpillDecoder&);
+    SpillDecoder& operator=(const SpillDecoder&);
+
+    void dumpEvents(unsigned int first, unsigned int last, bool withOpen);
+    void decodeTriggerTDC(const unsigned int* data, int nWordsTotal);
+    void compact();
+    void toScratch();
+
+public:
+    const RocMap* rocMap;
+    vector<ROC> rocs;       //in readout map order
+    int rocSlot[256];       //rocID -> index in rocs, -1 if not read out
+    bool ARMdead[256];      //by rocID
+    bool ARMdeadFlag;
+    vector<int> eventTys;
+
+    int spillID;
+    int targetPos;
+    int codaEventID;
+    int bosEventID;
+    int eosEventID;
+    int minSpillID;
+    bool firstBOS;
+    int event_counter;
+    bool sortHits;      //order hits of an event by (roc, board, channel)
+    DecoderStats* stats;    //run statistics to fill, not owned; none if 0
+    unsigned int buildWindow;   //streaming event builder, events to wait for a late board; 0 if off
+    unsigned int maxHits;       //streaming: built hits held in memory before the scratch file
+
+    SlowControl slowControl;    //of the spill being read
+    vector<BoardQA> boardQA;    //of the spill being read, every board in readout order
+    vector<TriggerTDCHit> triggerHits;  //of the spill being read
+
+    vector<Hit> hits;   //output of dump(), collected by the caller
+    vector<TriggerEvent> events;
+    vector<SpillRecord> spills;
+
+private:
+    unsigned int nSpillEvents;  //trigger events built in the spill
+    unsigned int nSpillHits;
+    unsigned int nBuilt;        //streaming: events of the spill built
+    unsigned int nCompacted;    //           and dropped from the boards
+    unsigned int firstEventTy;  //           spill index of eventTys[0]
+    FILE* scratch;
+    long scratchBytes;          //built events of the spill in the scratch file
+    long scratchRead;
+};
+
+#endif
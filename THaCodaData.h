@@ -22,7 +22,7 @@
 #define CODA_OK  0        // Means return is ok.
 #define MAXEVLEN 200000    // Maximum size of events
 #define CODA_VERBOSE 1    // Errors explained verbosely (recommended)
-#define CODA_DEBUG  1     // Lots of printout (recommend to set = 0)
+#define CODA_DEBUG  0     // Default of setDebug(): lots of printout (recommend 0)
 
 using namespace std;
 
@@ -38,7 +38,10 @@ public:
    virtual int codaClose()=0;
    virtual int codaRead()=0; 
    virtual unsigned *getEvBuffer() { return evbuffer; };     
+   virtual int getEvLength() const { return evbuffer[0]+1; };  // inclusive, in longwords
    virtual int getBuffSize() const { return MAXEVLEN; };
+   void setDebug(int level) { debug = level; };   // 1 = dump every event word by word
+   int getDebug() const { return debug; };
 
 private:
 
@@ -49,6 +52,7 @@ protected:
 
    TString filename;
    unsigned *evbuffer;                    // Raw data     
+   int debug;
 
 #ifndef STANDALONE
    ClassDef(THaCodaData,0) // Base class of CODA data (file, ET conn, etc)
@@ -0,0 +1,108 @@
+#ifndef THaCodaDecompress_h
+#define THaCodaDecompress_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaDecompress
+//  Block source for compressed CODA files
+//
+//  Archived runs are kept compressed with gzip, zstd or lz4.
+//  Instead of decompressing them to scratch disk first, the file
+//  is decompressed as a stream into evio's block reader (see
+//  evOpenSource).  The format is recognized by its magic number;
+//  each one needs its library at build time (HAVE_ZLIB,
+//  HAVE_ZSTD, HAVE_LZ4).
+//
+//  Decompression runs ahead of the reader on background threads,
+//  into a ring of nchunks chunks, like THaCodaPrefetch.  A plain
+//  stream is decompressed by one thread.  A zstd file in the
+//  seekable format (independent frames and a seek table at the
+//  end) is decompressed frame by frame on nthreads threads, and
+//  seek() goes straight to the frame that holds the position, so
+//  the index and evSeek work as on an uncompressed file.  On other
+//  streams seeking backward starts over from the beginning.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <stdio.h>
+#include <stdint.h>
+
+struct CodaInflater;
+
+class THaCodaDecompress
+{
+
+public:
+
+  enum { kNone = 0, kGzip, kZstd, kLz4 };
+
+  THaCodaDecompress(const char *filename, int nthreads = 2, int nchunks = 8,
+                    int chunkbytes = 4 << 20);
+  ~THaCodaDecompress();
+
+  static int detect(const char *filename);     // kNone for uncompressed
+  static const char *formatName(int format);
+  static int evOpenFile(const char *filename, const char *flags, long *handle,
+                        THaCodaDecompress **source);
+  static void setDefaultThreads(int n) { defthreads = n; };
+
+  int isOpen() const { return fp != 0 && !error; };
+  int getFormat() const { return format; };
+  int isSeekable() const { return !frames.empty(); };
+  int read(int *buf, int nwords);        // next nwords; fewer at EOF
+  int seek(long word);                   // next read from longword word
+  static int evioRead(void *ctx, int *buf, int nwords);
+  static int evioSeek(void *ctx, long word);
+
+private:
+
+  THaCodaDecompress(const THaCodaDecompress &);
+  THaCodaDecompress& operator=(const THaCodaDecompress &);
+
+  struct Frame {
+    int64_t  coffset;    // compressed frame in the file
+    uint32_t csize;
+    int64_t  doffset;    // its data in the uncompressed stream
+    uint32_t dsize;
+  };
+  struct Chunk {
+    std::vector<char> data;
+    long size;
+    long seq;
+    bool ready;
+  };
+
+  int readSeekTable();
+  void start(int firstframe);
+  void stop();
+  void streamWorker();
+  void frameWorker();
+  bool waitForSlot(std::unique_lock<std::mutex>& lock, long seq);
+  long copy(char *dest, long nbytes);
+
+  static int defthreads;
+  int format;
+  FILE *fp;
+  int nthreads, chunkbytes;
+  std::vector<Frame> frames;             // seekable zstd only
+  CodaInflater *inflater;                // plain streams
+
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::vector<Chunk> ring;
+  long nextseq;          // next chunk a worker takes
+  long endseq;           // number of chunks in the stream, -1 until known
+  long readseq;          // chunk being read
+  long readpos;          // bytes of it already read
+  int firstframe;        // frame of chunk 0 (seekable)
+  int64_t pos;           // uncompressed byte position of the reader
+  bool stopping, error;
+
+};
+
+#endif
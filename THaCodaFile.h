@@ -22,8 +22,15 @@
 #include <stdlib.h>
 #include "evio.h"
 #include "TString.h"
-#include "TArrayI.h"
+#include "THaCodaIndex.h"
+#include "THaCodaFilter.h"
 #include <iostream>
+#include <vector>
+
+class THaCodaPrefetch;
+class THaCodaDecompress;
+class THaCodaWriteBehind;
+class THaCodaSink;
 
 class THaCodaFile : public THaCodaData 
 {
@@ -40,23 +47,73 @@ public:
   int codaRead(); 
   int codaWrite(unsigned* evbuffer);
   unsigned *getEvBuffer();     
+  int getEvLength() const;
+  int isMapped() const { return mapped; };  // opened with "m" (zero-copy)
   int filterToFile(TString output_file);     // filter to an output file
+  int filterToFiles(const std::vector<THaCodaSink*>& sinks);  // to many, in one pass
   void addEvTypeFilt(int evtype_to_filt);    // add an event type to list
   void addEvListFilt(int event_to_filt);     // add an event num to list
+  void setSpillFilt(int first, int last);    // spill range (uses the index)
+  void addRocFilt(int rocid);                // physics events with this ROC
   void setMaxEvFilt(int max_event);          // max num events to filter
+  THaCodaFilter& getFilter() { return filter; };
+  int loadIndex();                           // read or build "<file>.idx"
+  int seekSpill(int spillID);                // next read is the spill's BOS
+  int seekEvent(int evnum);                  // next read is physics event evnum
+  int seekEntry(int ientry);                 // next read is index entry ientry
+  int seekOffset(long offset);               // next read is the event at byte offset
+  int setFollow(double poll, double idle);   // wait at EOF for a file being written
+  long getEvOffset() const { return evoffset; };   // follow: byte offset of the last event
+  int getEvBlock() const { return evblock; };      // follow: its block number
+  int getBlockNumber() const;                // EVFILE::blknum of the current block
+  int isOpen() const { return handle != 0; };
+  int getResyncs() const;                    // times reading resumed after corrupt data
+  long getSkippedBytes() const;              // bytes skipped by them
+  long getSkippedEvents() const;             // events lost by them
+  const THaCodaIndex* getIndex() const { return index; };
+  int setReadAhead(int nchunks, int chunkKB = 4096, bool direct = false);
+  const THaCodaPrefetch* getReadAhead() const { return prefetch; };
+  const THaCodaDecompress* getDecompress() const { return source; };  // compressed input
+  int setBlockSize(int nwords);              // "w": block size, before the first event
+  int setWriteBehind(int nchunks, int chunkKB = 4096, bool direct = false);  // "w" only
+  const THaCodaWriteBehind* getWriteBehind() const { return writer; };
+  void setFilterOutput(int blockwords, int nchunks = 0, int chunkKB = 4096,
+                       bool direct = false);     // filterToFile: same for its output
 
 private:
 
   THaCodaFile(const THaCodaFile &fn);
   THaCodaFile& operator=(const THaCodaFile &fn);
   void init(TString fname);
-  void initFilter();
-  void staterr(TString tried_to, int status);  // Can cause job to exit(0)
-  int ffirst;
+  int startReadAhead();
+  int followRead();
+  long fileSize() const;
+  int filterEntries(int& ientry, int& endentry, const std::vector<THaCodaSink*>& sinks);
+  int openSink(THaCodaSink& s);
+  int mirrorBlocks(THaCodaFile* fout, long from, int* stop);
+  void staterr(TString tried_to, int status);  // Explains an evio status
+  void reportResync(int status);
+  int mapped;
+  unsigned *evview;     // current event, points into the file map ("m")
+  int evlen;
   int max_to_filt;
   long handle;
-  int maxflist,maxftype;
-  TArrayI evlist, evtypes;
+  THaCodaFilter filter;
+  THaCodaIndex *index;
+  THaCodaPrefetch *prefetch;   // background reader ("r" mode only)
+  THaCodaDecompress *source;   // block source of a compressed file
+  THaCodaWriteBehind *writer;  // background writer ("w" mode only)
+  int outblksiz;               // setFilterOutput: output block size, 0 = as input
+  int wbchunks, wbchunkKB;     //   and write-behind, wbchunks = 0 for none
+  bool wbdirect;
+  int ranchunks, rachunkKB;
+  bool radirect;
+  int following;        // setFollow: codaRead waits for data at EOF
+  double followpoll, followidle;
+  long evoffset;
+  int evblock;
+  int resyncs;          // counts of evio's resyncs, as last reported
+  long skipbytes, skipevents;
 
 #ifndef STANDALONE
   ClassDef(THaCodaFile,0)   //  File of CODA data
@@ -0,0 +1,65 @@
+#ifndef THaCodaFilter_h
+#define THaCodaFilter_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaFilter
+//  Event selection for THaCodaFile::filterToFile
+//
+//  An event is kept if it passes every criterion that was set:
+//    - its CODA event type is one of the listed types,
+//    - its event number (word 4) is one of the listed numbers,
+//    - it belongs to a spill in the spill range (needs the index),
+//    - for physics (trigger) events, types 1 to 10: it has a bank
+//      of every listed ROC.
+//  With no criteria at all every event passes.  Lookups are O(1):
+//  types and ROCs are bitmaps, event numbers a bitmap as well up to
+//  kMaxEvBits and a hash set beyond.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <unordered_set>
+#include <stdint.h>
+
+class THaCodaFilter
+{
+
+public:
+
+  enum { kMaxEvBits = 1 << 26 };     // 8 MB of event number bitmap
+
+  THaCodaFilter();
+
+  void addEvType(int evtype);
+  void addEvNum(int evnum);
+  void setSpillRange(int first, int last);
+  void addRoc(int rocid);
+  void clear();
+
+  int isEmpty() const { return !ntypes && !nevnums && !hasSpillRange() && !nrocs; };
+  int hasSpillRange() const { return spillfirst <= spilllast; };
+  int inSpillRange(int spill) const { return spill >= spillfirst && spill <= spilllast; };
+  int getNumEvTypes() const { return ntypes; };
+  int getNumEvNums() const { return nevnums; };
+
+  // spill is the spill the event belongs to, ignored without a range
+  int pass(const unsigned *data, int len, int spill) const;
+
+private:
+
+  static int testBit(const std::vector<uint64_t>& bits, unsigned i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+  };
+  int hasRocs(const unsigned *data, int len) const;
+
+  int ntypes, nevnums, nrocs;
+  std::vector<uint64_t> typebits;      // 65536 event types
+  std::vector<uint64_t> evbits;        // event numbers 0 .. kMaxEvBits-1
+  std::unordered_set<int> evset;       // the others
+  std::vector<uint64_t> rocbits;       // 256 ROC IDs
+  int spillfirst, spilllast;
+
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef THaCodaIndex_h
+#define THaCodaIndex_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaIndex
+//  Event/spill index of a CODA file
+//
+//  One pass over a CODA run file records, for every event, its
+//  byte offset, CODA event type, physics event number and the
+//  spill it belongs to.  The table is kept in a sidecar file
+//  "<run>.dat.idx" next to the data, so later jobs can jump to
+//  "spill N" or "event K" with evSeek() instead of scanning.
+//
+//  A spill runs from its BOS (type 11) event up to, but not
+//  including, the next BOS or the end-of-run (type 20) event.
+//  Its ID is the spill counter (type 129) value in effect when
+//  the spill is closed, which is what the decoder labels it with.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "TString.h"
+#include <vector>
+#include <unordered_map>
+#include <stdint.h>
+
+struct CodaIndexEntry {
+  int64_t  offset;    // byte offset of the event header in the file
+  int32_t  evtype;    // CODA event type (data[1] >> 16)
+  int32_t  evnum;     // physics event number (data[4]), -1 otherwise
+  int32_t  spill;     // spill ID, -1 before the first BOS
+  uint32_t length;    // event length in longwords, header inclusive
+};
+
+struct CodaSpillEntry {
+  int32_t  spill;     // spill ID
+  uint32_t first;     // entry index of the BOS event
+  uint32_t nevents;   // entries up to the next BOS / end of run
+  uint32_t flags;     // kClosedByEOR if ended by the end-of-run event
+};
+
+class THaCodaIndex
+{
+
+public:
+
+  enum { kClosedByEOR = 1 };
+
+  THaCodaIndex();
+  ~THaCodaIndex();
+
+  int build(TString datfile);          // scan datfile and fill tables
+  int write(TString idxfile) const;
+  int read(TString idxfile, TString datfile);
+  int open(TString datfile);           // read sidecar, (re)build if stale
+
+  static TString sidecarName(TString datfile) { return datfile + ".idx"; };
+  static int spillIDFromEvent(const unsigned *data, int len);
+
+  int nEntries() const { return entries.size(); };
+  int nSpills() const { return spills.size(); };
+  const CodaIndexEntry& entry(int i) const { return entries[i]; };
+  const CodaSpillEntry& spillEntry(int i) const { return spills[i]; };
+  const std::vector<CodaSpillEntry>& getSpills() const { return spills; };
+
+  const CodaSpillEntry* findSpill(int spillID) const;
+  const CodaIndexEntry* findEvent(int evnum) const;
+
+private:
+
+  void fillLookups();
+  int64_t fileSize(TString datfile) const;
+
+  int64_t datsize;                     // size of the indexed file
+  std::vector<CodaIndexEntry> entries;
+  std::vector<CodaSpillEntry> spills;
+  std::unordered_map<int, int> spillmap;   // spill ID -> spills[]
+  std::unordered_map<int, int> evmap;      // evnum -> entries[]
+
+};
+
+inline int THaCodaIndex::spillIDFromEvent(const unsigned *data, int len) {
+// Spill counter (type 129) events carry the spill ID as ASCII text
+// from word 4 on.  Same result as building the string and calling
+// TString::Atoi on it: NULs and blanks are dropped, then atoi().
+  int value = 0, sign = 1, started = 0;
+  for (int i = 4; i < len; i++) {
+    for (int j = 0; j < 4; j++) {
+      char c = (data[i] >> (j*8)) & 0xff;
+      if (c == '\0' || c == ' ') continue;
+      if (!started) {
+        if (c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r') continue;
+        started = 1;
+        if (c == '-' || c == '+') {
+          if (c == '-') sign = -1;
+          continue;
+        }
+      }
+      if (c < '0' || c > '9') return sign*value;
+      value = 10*value + (c - '0');
+    }
+  }
+  return sign*value;
+}
+
+#endif
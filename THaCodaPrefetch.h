@@ -0,0 +1,73 @@
+#ifndef THaCodaPrefetch_h
+#define THaCodaPrefetch_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaPrefetch
+//  Read-ahead of a CODA file on a background thread
+//
+//  An I/O thread keeps a ring of nchunks large, page aligned
+//  chunks filled ahead of the reader with pread(), optionally
+//  through O_DIRECT.  The reader (evio, via evSetBlockSource)
+//  copies blocks out of resident chunks and only waits when the
+//  ring has run dry; those waits are counted as stalls.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <iostream>
+
+class THaCodaPrefetch
+{
+
+public:
+
+  THaCodaPrefetch(const char *filename, long start, int nchunks,
+                  int chunkbytes, bool direct = false);
+  ~THaCodaPrefetch();
+
+  int isOpen() const { return fd >= 0; };
+  int read(int *buf, int nwords);        // next nwords; fewer at EOF
+  static int evioRead(void *ctx, int *buf, int nwords);
+
+  long getStalls() const { return nstalls; };
+  double getStallTime() const { return stalltime; };   // seconds
+  long getChunksRead() const { return nchunks_read; };
+  void printStats(std::ostream& os) const;
+
+private:
+
+  THaCodaPrefetch(const THaCodaPrefetch &fn);
+  THaCodaPrefetch& operator=(const THaCodaPrefetch &fn);
+  void run();
+
+  enum { kFree = 0, kFull };
+  struct Chunk {
+    char *data;
+    long nbytes;           // valid bytes, < chunk size at end of file
+    int state;
+  };
+
+  int fd;
+  long chunkbytes;
+  long filepos;            // next offset the I/O thread reads
+  std::vector<Chunk> ring;
+  int head;                // chunk the reader is in
+  long headpos;            // byte position inside it
+  int tail;                // next chunk the I/O thread fills
+  bool eof, stop;
+
+  long nstalls;
+  double stalltime;
+  long nchunks_read;
+
+  std::mutex mtx;
+  std::condition_variable filled, freed;
+  std::thread io;
+
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef THaCodaRun_h
+#define THaCodaRun_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaRun
+//  CODA run split into segment files
+//
+//  CODA closes a run file at a size limit and goes on writing
+//  the next segment, run.dat.0, run.dat.1, ...; a spill can start
+//  in one segment and end in the next.  THaCodaRun reads the
+//  segments as one stream: codaRead() continues with the next
+//  segment at the end of one, so a decoder sees the run as if it
+//  were a single file.
+//
+//  buildSpills() indexes all segments (concurrently) and joins
+//  their spill tables into a table of the run, in which a spill
+//  cut by a segment boundary appears once, with the ID it gets
+//  when it is closed in a later segment.
+//
+//  codaOpen() takes a comma separated list of segments, or the
+//  first segment "<run>.0", in which case "<run>.1", "<run>.2",
+//  ... are added as long as they exist.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaCodaData.h"
+#include "THaCodaIndex.h"
+#include "TString.h"
+#include <vector>
+#include <stdint.h>
+
+class THaCodaFile;
+
+struct CodaRunSpill {
+  int32_t  spill;     // spill ID
+  int32_t  segment;   // segment of the BOS event
+  uint32_t first;     // entry index of the BOS event in its segment
+  uint32_t runentry;  // entry index of the BOS event in the run
+  int32_t  prevspill; // spill counter in effect at the BOS
+  uint32_t flags;     // kClosedByEOR, kStitched
+};
+
+class THaCodaRun : public THaCodaData
+{
+
+public:
+
+  enum { kClosedByEOR = THaCodaIndex::kClosedByEOR, kStitched = 2 };
+
+  THaCodaRun();
+  THaCodaRun(TString segments, TString rw = "m");
+  ~THaCodaRun();
+  int codaOpen(TString segments);
+  int codaOpen(TString segments, TString rw);
+  int codaClose();
+  int codaRead();
+  unsigned *getEvBuffer();
+  int getEvLength() const;
+
+  static std::vector<TString> segmentNames(TString segments);
+  int setReadAhead(int nchunks);                     // for every segment opened with "r"
+  int nSegments() const { return names.size(); };
+  int isOpen() const;                               // the segment being read is open
+  const TString& getSegmentName(int iseg) const { return names[iseg]; };
+  int getSegment() const { return segment; };       // segment of the last event read
+  int getResyncs() const;                            // corrupt data skipped, all segments read
+  long getSkippedBytes() const;
+  long getSkippedEvents() const;
+
+  int buildSpills(int nthreads = 1);                 // index all segments, join spills
+  int nSpills() const { return spills.size(); };
+  const CodaRunSpill& spillEntry(int i) const { return spills[i]; };
+  const CodaRunSpill* findSpill(int spillID) const;
+  int seekSpill(int spillID);                        // next read is the spill's BOS
+  int seekEntry(int iseg, int ientry);               // next read is entry ientry of segment iseg
+
+private:
+
+  THaCodaRun(const THaCodaRun &fn);
+  THaCodaRun& operator=(const THaCodaRun &fn);
+  int openSegment(int iseg);
+  void closeSegment();
+  int readSpillCounter(int iseg, int ientry);
+
+  std::vector<TString> names;
+  TString mode;
+  int readahead;
+  int segment;
+  THaCodaFile *file;                     // the segment being read
+  int resyncs;                           // of the segments closed so far
+  long skipbytes, skipevents;
+  std::vector<THaCodaIndex*> indexes;    // by segment, filled by buildSpills
+  std::vector<CodaRunSpill> spills;
+
+#ifndef STANDALONE
+  ClassDef(THaCodaRun,0)   //  CODA run of segment files
+#endif
+
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef THaCodaSink_h
+#define THaCodaSink_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaSink
+//  One output of THaCodaFile::filterToFiles
+//
+//  A skim: its own THaCodaFilter, maximum number of events, output
+//  file, and block size and write-behind of that file (see
+//  THaCodaFile::setWriteBehind).  filterToFiles reads the input
+//  once and feeds every event to all of its sinks, each written
+//  by its own thread when write-behind is on.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "TString.h"
+#include "THaCodaFilter.h"
+
+class THaCodaFile;
+
+class THaCodaSink
+{
+
+public:
+
+  THaCodaSink(TString output_file);
+  ~THaCodaSink();
+
+  THaCodaFilter& getFilter() { return filter; };
+  const THaCodaFilter& getFilter() const { return filter; };
+  void setMaxEvents(int max_event) { max_to_filt = max_event; };   // 0: no limit
+  void setOutput(int blockwords, int nchunks = 0, int chunkKB = 4096,
+                 bool direct = false);   // block size (0: as input) and write-behind
+  const TString& getFileName() const { return filename; };
+  long getNumKept() const { return nkept; };        // after filterToFiles
+  int getStatus() const { return status; };         // S_SUCCESS unless its writes failed
+
+private:
+
+  THaCodaSink(const THaCodaSink &fn);
+  THaCodaSink& operator=(const THaCodaSink &fn);
+  friend class THaCodaFile;
+
+  TString filename;
+  THaCodaFilter filter;
+  int max_to_filt;
+  int blockwords, nchunks, chunkKB;
+  bool direct;
+
+  // state of a filterToFiles pass
+  THaCodaFile *fout;
+  int canmirror;
+  int mirror;           // kept events not written yet, from block mfrom on
+  long mfrom;
+  long nkept;
+  int done;             // max_to_filt reached, or failed
+  int status;
+
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef THaCodaWriteBehind_h
+#define THaCodaWriteBehind_h
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaWriteBehind
+//  Write-behind of a CODA file on a background thread
+//
+//  The writer (evio, via evSetBlockSink) copies its blocks into a
+//  ring of nchunks large, page aligned chunks; an I/O thread
+//  writes full chunks out with pwrite(), optionally through
+//  O_DIRECT.  The writer only waits when every chunk is still
+//  waiting to be written; those waits are counted as stalls.
+//  Write errors show up as a short write() and in close().
+//
+/////////////////////////////////////////////////////////////////////
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <iostream>
+
+class THaCodaWriteBehind
+{
+
+public:
+
+  THaCodaWriteBehind(const char *filename, long start, int nchunks,
+                     int chunkbytes, bool direct = false);
+  ~THaCodaWriteBehind();
+
+  int isOpen() const { return fd >= 0; };
+  int write(const int *buf, int nwords); // nwords; fewer after an error
+  int close();                           // drains the ring; 0 or errno
+  static int evioWrite(void *ctx, int *buf, int nwords);
+
+  long getStalls() const { return nstalls; };
+  double getStallTime() const { return stalltime; };   // seconds
+  long getChunksWritten() const { return nchunks_written; };
+  void printStats(std::ostream& os) const;
+
+private:
+
+  THaCodaWriteBehind(const THaCodaWriteBehind &fn);
+  THaCodaWriteBehind& operator=(const THaCodaWriteBehind &fn);
+  void run();
+
+  enum { kFree = 0, kFull };
+  struct Chunk {
+    char *data;
+    long nbytes;           // bytes to write, < chunk size for the last
+    int state;
+  };
+
+  int fd;
+  bool direct;
+  long chunkbytes;
+  long filepos;            // next offset the I/O thread writes
+  std::vector<Chunk> ring;
+  int head;                // chunk the writer fills
+  long headpos;            // bytes of it filled
+  int tail;                // next chunk the I/O thread writes
+  bool closing;
+  int error;               // errno of the first failed write
+
+  long nstalls;
+  double stalltime;
+  long nchunks_written;
+
+  std::mutex mtx;
+  std::condition_variable filled, freed;
+  std::thread io;
+
+};
+
+#endif
@@ -12,6 +12,12 @@
 //   This code works locally or remotely and uses the
 //   ET system in a particular mode favored by  hall A.
 //
+//   Events are not copied: codaRead() returns views into
+//   the ET events, valid until the next codaRead().  The
+//   chunk API hands out a whole chunk of ET_CHUNK_SIZE
+//   events at once, swapped and checked when it is read,
+//   and gives it back to ET on releaseChunk().
+//
 //   Robert Michaels (rom@jlab.org)
 //
 /////////////////////////////////////////////////////////////////////
@@ -62,18 +68,30 @@ public:
     int codaClose();
     ~THaEtClient();
     unsigned *getEvBuffer();        // Gets next event buffer after codaRead()
+    int getEvLength() const { return evlen; };
     int codaRead();            // codaRead() must be called once per event
 
+    int readChunk();           // next chunk of events from ET, returns their number
+    int getChunkSize() const { return nread; };
+    unsigned *getChunkEvent(int i) const { return chunkev[i]; };   // 0 if bad
+    int getChunkEventLength(int i) const { return chunklen[i]; };  // longwords
+    int releaseChunk();        // put the chunk back into ET
+
 private:
 
     THaEtClient(const THaEtClient &fn);
     THaEtClient& operator=(const THaEtClient &fn);
     int CHUNK;
-    int DEBUG; 
     int FAST; 
     int SMALL_TIMEOUT; 
     int BIG_TIMEOUT; 
     int nread, nused, timeout;
+    et_event *evs[ET_CHUNK_SIZE];      // chunk held from ET, if held
+    unsigned *chunkev[ET_CHUNK_SIZE];  // event data in the chunk
+    int chunklen[ET_CHUNK_SIZE];
+    int held;
+    unsigned *evview;                  // current event of codaRead()
+    int evlen;
     et_sys_id id;
     et_statconfig sconfig;
     et_stat_id my_stat;
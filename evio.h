@@ -45,15 +45,37 @@ typedef struct evfilestruct {
   int blknum;
   int rw;
   int magic;
-  int evnum;         /* last events with evnum so far */
+  int evnum;         /* last events with evnum so far (read: events read) */
   int byte_swapped;
+  int *map;          /* read-only mapping of the whole file ('m' mode) */
+  long maplen;       /* length of the mapping in longwords */
+  long mappos;       /* longword offset of the next block in the mapping */
+  int *scratch;      /* assembly buffer for events spanning blocks */
+  int scratchlen;    /* size of scratch in longwords */
+  int (*blkread)(void *, int *, int);  /* block source replacing fread, or NULL */
+  int (*blkseek)(void *, long);        /* repositions the block source, or NULL */
+  int (*blkwrite)(void *, int *, int); /* block sink replacing fwrite ('w'), or NULL */
+  void *blkctx;      /* argument passed to blkread, blkseek or blkwrite */
+  long srcpos;       /* longword offset of the next block in the source (not mapped) */
+  int resync;        /* evIoctl 's': skip corrupt data instead of failing */
+  int nresync;       /* number of times reading was resumed after corrupt data */
+  long skipbytes;    /* bytes passed over by the resyncs */
+  long skipevents;   /* events lost by the resyncs, from EV_HD_RESVD */
+  long resyncpos;    /* byte offset of the event the last resync resumed at */
 } EVFILE;
 
 
 extern int evOpen(char *filename, char *flags, long *handle);
 extern int evRead(long handle, unsigned *buffer, int buflen);
+extern int evReadView(long handle, unsigned **view, int *len);
 extern int evGetNewBuffer(EVFILE *a);
+extern int evTell(long handle, long *offset);
+extern int evSeek(long handle, long offset);
+extern int evSetBlockSource(long handle, int (*blkread)(void *, int *, int), void *ctx);
+extern int evOpenSource(int (*blkread)(void *, int *, int), int (*blkseek)(void *, long), void *ctx, long *handle);
 extern int evWrite(long handle,unsigned *buffer);
+extern int evWriteBlock(long handle,int *block,int used);
+extern int evSetBlockSink(long handle, int (*blkwrite)(void *, int *, int), void *ctx);
 extern int evFlush(EVFILE *a);
 extern int evIoctl(long handle,char *request,void *argp);
 extern int evClose(long handle);